@@ -5,6 +5,13 @@
 #include <math.h>
 #include <string.h>
 #include <time.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 #define MAX_NODES 100
 #define MAX_VEHICLES 10
@@ -12,6 +19,24 @@
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 #define DEBUG_PRINT(fmt, ...) printf("[DEBUG] " fmt "\n", ##__VA_ARGS__)
+#define MAX_VEHICLE_TYPES 8
+#define MAX_TYPE_NAME 16
+#define OUT_BUFFER_SIZE 65536
+#define CHECKPOINT_VERSION 1
+#define ROUTE_CACHE_SETS 1024  // Power of two
+#define ROUTE_CACHE_WAYS 4
+
+// Constraint set compiled into the feasibility checks. Build with e.g.
+// -DVRP_CONSTRAINTS=VRP_C_CAPACITY for plain CVRP; disabled checks are
+// constant-folded away so unused constraints cost nothing at runtime.
+#define VRP_C_CAPACITY     (1 << 0)
+#define VRP_C_TIME_WINDOWS (1 << 1)
+#define VRP_C_SHIFTS       (1 << 2)
+#define VRP_C_MULTI_DEPOT  (1 << 3)
+#ifndef VRP_CONSTRAINTS
+#define VRP_CONSTRAINTS (VRP_C_CAPACITY | VRP_C_TIME_WINDOWS | VRP_C_SHIFTS | VRP_C_MULTI_DEPOT)
+#endif
+#define VRP_HAS(c) ((VRP_CONSTRAINTS & (c)) != 0)
 
 // Structure to represent a time window
 typedef struct {
@@ -28,8 +53,21 @@ typedef struct {
     int demand;            // Customer demand
 } Customer;
 
+// Structure to represent a vehicle type (van, truck, ...)
+typedef struct {
+    char name[MAX_TYPE_NAME];
+    int capacity;
+    int fixed_cost;      // Charged once if the vehicle leaves its depot
+    int variable_cost;   // Charged per distance unit travelled
+    int shift_start;
+    int shift_end;
+} VehicleType;
+
 // Structure to represent a vehicle
 typedef struct {
+    int type_id;
+    int start_depot;
+    int end_depot;
     int capacity;
     int current_load;
     int current_time;
@@ -40,11 +78,193 @@ typedef struct {
 } Vehicle;
 
 
+// Result of simulating a route against the active constraints
+typedef struct {
+    int distance;
+    int duration;
+    int load;
+    bool feasible;
+} RouteEval;
+
+// Route evaluation cache entry. Readers never lock: they check that the
+// sequence counter is even and unchanged around the copy (seqlock), so
+// fields are atomics to keep concurrent reads and writes well defined.
+typedef struct {
+    atomic_uint seq;              // Odd while a writer is updating the entry
+    atomic_uint_fast64_t key_hi;  // 128-bit fingerprint of type + sequence
+    atomic_uint_fast64_t key_lo;
+    atomic_uint_fast64_t metrics; // distance << 32 | duration
+    atomic_uint_fast64_t state;   // load << 32 | feasible << 1 | valid
+    atomic_bool referenced;       // CLOCK reference bit
+} RouteCacheEntry;
+
+typedef struct {
+    RouteCacheEntry entries[ROUTE_CACHE_WAYS];
+    atomic_uint hand;             // CLOCK hand within the set
+} RouteCacheSet;
+
+// Route of a previous solution, used to warm-start construction
+typedef struct {
+    int type_id;
+    int start_depot;
+    int end_depot;
+    int size;
+    int nodes[MAX_NODES];
+} SavedRoute;
+
 // Global variables
 Customer customers[MAX_NODES];
 int distances[MAX_NODES][MAX_NODES];
 Vehicle vehicles[MAX_VEHICLES];
-int n_customers, n_vehicles;
+VehicleType vehicle_types[MAX_VEHICLE_TYPES];
+int n_customers, n_vehicles, n_vehicle_types;
+int n_depots = 1;  // Nodes [0, n_depots) are depots, the rest are customers
+uint64_t rng_seed_value, rng_state;
+const char* checkpoint_path = NULL;  // Autosave target, if any
+RouteCacheSet route_cache[ROUTE_CACHE_SETS];
+atomic_ullong route_cache_hits, route_cache_misses, route_cache_evictions;
+
+// xorshift64* generator; unlike rand() its state can be checkpointed
+void rng_seed(uint64_t seed) {
+    rng_seed_value = seed;
+    rng_state = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+uint64_t rng_next() {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+// Random integer in [0, n)
+int rng_int(int n) {
+    return (int)(rng_next() % (uint64_t)n);
+}
+
+static inline bool is_depot(int node) {
+    return node < n_depots;
+}
+
+// Depot fields are only honoured when multi-depot routing is compiled in
+static inline int vehicle_start_depot(const Vehicle* vehicle) {
+    return VRP_HAS(VRP_C_MULTI_DEPOT) ? vehicle->start_depot : 0;
+}
+
+static inline int vehicle_end_depot(const Vehicle* vehicle) {
+    return VRP_HAS(VRP_C_MULTI_DEPOT) ? vehicle->end_depot : 0;
+}
+
+static inline int vehicle_shift_start(const Vehicle* vehicle) {
+    return VRP_HAS(VRP_C_SHIFTS) ? vehicle_types[vehicle->type_id].shift_start : 0;
+}
+
+// Drop every cached route evaluation. Must not run concurrently with
+// lookups; call it whenever distances or customer data change.
+void route_cache_clear() {
+    for (int s = 0; s < ROUTE_CACHE_SETS; s++) {
+        for (int w = 0; w < ROUTE_CACHE_WAYS; w++) {
+            RouteCacheEntry* entry = &route_cache[s].entries[w];
+            atomic_store(&entry->state, 0);
+            atomic_store(&entry->referenced, false);
+        }
+        atomic_store(&route_cache[s].hand, 0);
+    }
+    atomic_store(&route_cache_hits, 0);
+    atomic_store(&route_cache_misses, 0);
+    atomic_store(&route_cache_evictions, 0);
+}
+
+// Two independent 64-bit hashes of the vehicle type and customer sequence
+static void route_fingerprint(int type_id, const int* route, int size,
+                              uint64_t* hi, uint64_t* lo) {
+    uint64_t h1 = 0xCBF29CE484222325ULL;  // FNV-1a
+    uint64_t h2 = 0x9E3779B97F4A7C15ULL ^ (uint64_t)size;
+    
+    for (int i = -1; i < size; i++) {
+        uint64_t v = (uint32_t)(i < 0 ? type_id : route[i]);
+        for (int b = 0; b < 4; b++) {
+            h1 = (h1 ^ ((v >> (8 * b)) & 0xFF)) * 0x100000001B3ULL;
+        }
+        h2 = (h2 ^ v) * 0xBF58476D1CE4E5B9ULL;
+        h2 ^= h2 >> 31;
+    }
+    
+    *hi = h1;
+    *lo = h2;
+}
+
+// Lock-free lookup; returns false on a miss or while the entry is being written
+bool route_cache_lookup(uint64_t hi, uint64_t lo, RouteEval* result) {
+    RouteCacheSet* set = &route_cache[lo & (ROUTE_CACHE_SETS - 1)];
+    
+    for (int w = 0; w < ROUTE_CACHE_WAYS; w++) {
+        RouteCacheEntry* entry = &set->entries[w];
+        unsigned seq = atomic_load_explicit(&entry->seq, memory_order_acquire);
+        if (seq & 1) continue;
+        
+        uint64_t key_hi = atomic_load_explicit(&entry->key_hi, memory_order_relaxed);
+        uint64_t key_lo = atomic_load_explicit(&entry->key_lo, memory_order_relaxed);
+        uint64_t metrics = atomic_load_explicit(&entry->metrics, memory_order_relaxed);
+        uint64_t state = atomic_load_explicit(&entry->state, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&entry->seq, memory_order_relaxed) != seq) continue;
+        
+        if ((state & 1) && key_hi == hi && key_lo == lo) {
+            atomic_store_explicit(&entry->referenced, true, memory_order_relaxed);
+            result->distance = (int32_t)(metrics >> 32);
+            result->duration = (int32_t)(uint32_t)metrics;
+            result->load = (int32_t)(state >> 32);
+            result->feasible = (state >> 1) & 1;
+            atomic_fetch_add_explicit(&route_cache_hits, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+    
+    atomic_fetch_add_explicit(&route_cache_misses, 1, memory_order_relaxed);
+    return false;
+}
+
+// Insert using CLOCK eviction within the set. If another thread is
+// writing the chosen entry the insert is simply skipped.
+void route_cache_insert(uint64_t hi, uint64_t lo, const RouteEval* result) {
+    RouteCacheSet* set = &route_cache[lo & (ROUTE_CACHE_SETS - 1)];
+    RouteCacheEntry* victim = NULL;
+    
+    for (int step = 0; step < 2 * ROUTE_CACHE_WAYS; step++) {
+        unsigned way = atomic_fetch_add_explicit(&set->hand, 1, memory_order_relaxed) % ROUTE_CACHE_WAYS;
+        RouteCacheEntry* entry = &set->entries[way];
+        if (!(atomic_load_explicit(&entry->state, memory_order_relaxed) & 1) ||
+            !atomic_exchange_explicit(&entry->referenced, false, memory_order_relaxed)) {
+            victim = entry;
+            break;
+        }
+    }
+    if (!victim) return;
+    
+    unsigned seq = atomic_load_explicit(&victim->seq, memory_order_relaxed);
+    if ((seq & 1) || !atomic_compare_exchange_strong_explicit(&victim->seq, &seq, seq + 1,
+                                                              memory_order_acquire,
+                                                              memory_order_relaxed)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+    
+    if (atomic_load_explicit(&victim->state, memory_order_relaxed) & 1) {
+        atomic_fetch_add_explicit(&route_cache_evictions, 1, memory_order_relaxed);
+    }
+    atomic_store_explicit(&victim->key_hi, hi, memory_order_relaxed);
+    atomic_store_explicit(&victim->key_lo, lo, memory_order_relaxed);
+    atomic_store_explicit(&victim->metrics,
+                          ((uint64_t)(uint32_t)result->distance << 32) | (uint32_t)result->duration,
+                          memory_order_relaxed);
+    atomic_store_explicit(&victim->state,
+                          ((uint64_t)(uint32_t)result->load << 32) | ((uint64_t)result->feasible << 1) | 1,
+                          memory_order_relaxed);
+    atomic_store_explicit(&victim->referenced, false, memory_order_relaxed);
+    
+    atomic_store_explicit(&victim->seq, seq + 2, memory_order_release);
+}
 
 // Calculate Euclidean distance between two points
 int calculate_distance(Customer a, Customer b) {
@@ -56,6 +276,7 @@ int calculate_distance(Customer a, Customer b) {
 // Initialize the distance matrix
 void initialize_distances() {
     DEBUG_PRINT("Initializing distance matrix");
+    route_cache_clear();
     for (int i = 0; i < n_customers; i++) {
         for (int j = 0; j < n_customers; j++) {
             distances[i][j] = calculate_distance(customers[i], customers[j]);
@@ -64,9 +285,18 @@ void initialize_distances() {
     }
 }
 
+// Time a vehicle finishes serving customer_id if it arrives at arrival_time
+static inline int departure_time(int customer_id, int arrival_time) {
+    if (VRP_HAS(VRP_C_TIME_WINDOWS) && arrival_time < customers[customer_id].time_window.earliest) {
+        arrival_time = customers[customer_id].time_window.earliest;
+    }
+    return arrival_time + customers[customer_id].time_window.service_time;
+}
+
 // Check if adding a customer to a vehicle's route is feasible
 bool is_feasible(Vehicle* vehicle, int customer_id) {
-    if (vehicle->current_load + customers[customer_id].demand > vehicle->capacity) {
+    if (VRP_HAS(VRP_C_CAPACITY) &&
+        vehicle->current_load + customers[customer_id].demand > vehicle->capacity) {
         DEBUG_PRINT("Customer %d exceeds vehicle capacity", customer_id);
         return false;
     }
@@ -74,14 +304,88 @@ bool is_feasible(Vehicle* vehicle, int customer_id) {
     int arrival_time = vehicle->current_time + 
         distances[vehicle->current_location][customer_id];
     
-    if (arrival_time > customers[customer_id].time_window.latest) {
+    if (VRP_HAS(VRP_C_TIME_WINDOWS) && arrival_time > customers[customer_id].time_window.latest) {
         DEBUG_PRINT("Customer %d time window violation", customer_id);
         return false;
     }
     
+    // The vehicle must still be able to reach its end depot before the shift ends
+    if (VRP_HAS(VRP_C_SHIFTS) &&
+        departure_time(customer_id, arrival_time) +
+        distances[customer_id][vehicle_end_depot(vehicle)] >
+        vehicle_types[vehicle->type_id].shift_end) {
+        DEBUG_PRINT("Customer %d shift end violation", customer_id);
+        return false;
+    }
+    
     return true;
 }
 
+// Simulate a complete route and check it against the active constraints
+void evaluate_route(Vehicle* vehicle, RouteEval* result) {
+    int current_time = vehicle_shift_start(vehicle);
+    
+    result->distance = 0;
+    result->load = 0;
+    result->feasible = true;
+    
+    for (int i = 1; i < vehicle->route_size; i++) {
+        int customer = vehicle->route[i];
+        int leg = distances[vehicle->route[i-1]][customer];
+        result->distance += leg;
+        current_time += leg;
+        
+        if (is_depot(customer)) continue;
+        
+        if (VRP_HAS(VRP_C_TIME_WINDOWS) && current_time > customers[customer].time_window.latest) {
+            result->feasible = false;
+        }
+        
+        result->load += customers[customer].demand;
+        current_time = departure_time(customer, current_time);
+    }
+    
+    if (VRP_HAS(VRP_C_CAPACITY) && result->load > vehicle->capacity) {
+        result->feasible = false;
+    }
+    if (VRP_HAS(VRP_C_SHIFTS) && current_time > vehicle_types[vehicle->type_id].shift_end) {
+        result->feasible = false;
+    }
+    
+    result->duration = current_time - vehicle_shift_start(vehicle);
+}
+
+// evaluate_route through the route cache
+void evaluate_route_cached(Vehicle* vehicle, RouteEval* result) {
+    uint64_t hi, lo;
+    route_fingerprint(vehicle->type_id, vehicle->route, vehicle->route_size, &hi, &lo);
+    
+    if (route_cache_lookup(hi, lo, result)) return;
+    
+    evaluate_route(vehicle, result);
+    route_cache_insert(hi, lo, result);
+}
+
+bool is_route_feasible(Vehicle* vehicle) {
+    RouteEval eval;
+    evaluate_route_cached(vehicle, &eval);
+    return eval.feasible;
+}
+
+// Total travelled distance of a route
+int route_distance(Vehicle* vehicle) {
+    RouteEval eval;
+    evaluate_route_cached(vehicle, &eval);
+    return eval.distance;
+}
+
+// Cost of a route: fixed cost if the vehicle is used plus distance-based cost
+int route_cost(Vehicle* vehicle, int distance) {
+    if (vehicle->route_size <= 1) return 0;
+    VehicleType* type = &vehicle_types[vehicle->type_id];
+    return type->fixed_cost + type->variable_cost * distance;
+}
+
 // Dynamic programming for route optimization
 void optimize_route(Vehicle* vehicle) {
     DEBUG_PRINT("Optimizing route for vehicle");
@@ -90,7 +394,6 @@ void optimize_route(Vehicle* vehicle) {
     
     // Create temporary arrays for optimization
     int* best_route = (int*)malloc(vehicle->route_capacity * sizeof(int));
-    int best_cost = INF;
     
     if (!best_route) {
         fprintf(stderr, "Memory allocation failed in optimize_route\n");
@@ -125,45 +428,33 @@ void optimize_route(Vehicle* vehicle) {
         }
     } while (improved);
     
-    // Verify time windows are still satisfied
-    bool feasible = true;
-    int current_time = 0;
-    
-    for (int i = 1; i < vehicle->route_size; i++) {
-        int customer = vehicle->route[i];
-        current_time += distances[vehicle->route[i-1]][customer];
-        
-        if (current_time > customers[customer].time_window.latest) {
-            feasible = false;
-            break;
-        }
-        
-        if (current_time < customers[customer].time_window.earliest) {
-            current_time = customers[customer].time_window.earliest;
-        }
-        
-        current_time += customers[customer].time_window.service_time;
-    }
+    // Verify time windows and shift are still satisfied
+    bool feasible = is_route_feasible(vehicle);
     
     // Restore best route if new route is infeasible
     if (!feasible) {
         memcpy(vehicle->route, best_route, vehicle->route_size * sizeof(int));
     }
     
+    // Re-simulate the accepted order so time, load and location match it
+    RouteEval eval;
+    evaluate_route_cached(vehicle, &eval);
+    vehicle->current_time = vehicle_shift_start(vehicle) + eval.duration;
+    vehicle->current_load = eval.load;
+    vehicle->current_location = vehicle->route[vehicle->route_size - 1];
+    
     free(best_route);
     DEBUG_PRINT("Route optimization completed");
 }
 
-// Construct initial solution
-void construct_initial_solution() {
-    DEBUG_PRINT("Constructing initial solution");
-    
-    // Initialize vehicles
+// Reset every vehicle to an empty route at its start depot
+void init_vehicles() {
     for (int i = 0; i < n_vehicles; i++) {
-        vehicles[i].capacity = 100;
+        free(vehicles[i].route);
+        vehicles[i].capacity = vehicle_types[vehicles[i].type_id].capacity;
         vehicles[i].current_load = 0;
-        vehicles[i].current_time = 0;
-        vehicles[i].current_location = 0;
+        vehicles[i].current_time = vehicle_shift_start(&vehicles[i]);
+        vehicles[i].current_location = vehicle_start_depot(&vehicles[i]);
         vehicles[i].route_capacity = MAX_NODES;
         vehicles[i].route = (int*)malloc(MAX_NODES * sizeof(int));
         if (!vehicles[i].route) {
@@ -171,12 +462,32 @@ void construct_initial_solution() {
             exit(1);
         }
         vehicles[i].route_size = 1;
-        vehicles[i].route[0] = 0;  // Start at depot
+        vehicles[i].route[0] = vehicles[i].current_location;  // Start at depot
         
         DEBUG_PRINT("Initialized vehicle %d", i);
     }
+}
+
+// Append a customer to the end of a vehicle's route if feasible
+bool append_customer(Vehicle* vehicle, int customer_id) {
+    if (!is_feasible(vehicle, customer_id)) return false;
+    
+    // Keep one slot free for the depot return
+    if (vehicle->route_size >= vehicle->route_capacity - 1) return false;
+    
+    int arrival_time = vehicle->current_time +
+        distances[vehicle->current_location][customer_id];
     
-    // Modified customer assignment logic
+    vehicle->route[vehicle->route_size++] = customer_id;
+    vehicle->current_load += customers[customer_id].demand;
+    vehicle->current_time = departure_time(customer_id, arrival_time);
+    vehicle->current_location = customer_id;
+    customers[customer_id].is_served = true;
+    return true;
+}
+
+// Greedily assign all unserved customers, filling one vehicle at a time
+void assign_remaining_customers() {
     bool customers_remaining = true;
     int current_vehicle = 0;
     
@@ -184,36 +495,13 @@ void construct_initial_solution() {
         customers_remaining = false;
         bool vehicle_assigned = false;
         
-        for (int i = 1; i < n_customers; i++) {
+        for (int i = n_depots; i < n_customers; i++) {
             if (!customers[i].is_served) {
                 customers_remaining = true;
-                Vehicle* vehicle = &vehicles[current_vehicle];
-                
-                // Calculate actual arrival time considering current route
-                int arrival_time = vehicle->current_time;
-                if (vehicle->route_size > 0) {
-                    arrival_time += distances[vehicle->current_location][i];
-                }
                 
-                // Check feasibility with proper time window handling
-                if (vehicle->current_load + customers[i].demand <= vehicle->capacity &&
-                    arrival_time <= customers[i].time_window.latest) {
-                    
-                    // Adjust arrival time if arriving before earliest time window
-                    if (arrival_time < customers[i].time_window.earliest) {
-                        arrival_time = customers[i].time_window.earliest;
-                    }
-                    
-                    // Add customer to route
-                    if (vehicle->route_size < vehicle->route_capacity) {
-                        vehicle->route[vehicle->route_size++] = i;
-                        vehicle->current_load += customers[i].demand;
-                        vehicle->current_time = arrival_time + customers[i].time_window.service_time;
-                        vehicle->current_location = i;
-                        customers[i].is_served = true;
-                        vehicle_assigned = true;
-                        DEBUG_PRINT("Assigned customer %d to vehicle %d", i, current_vehicle);
-                    }
+                if (append_customer(&vehicles[current_vehicle], i)) {
+                    vehicle_assigned = true;
+                    DEBUG_PRINT("Assigned customer %d to vehicle %d", i, current_vehicle);
                 } else {
                     DEBUG_PRINT("Customer %d not feasible for vehicle %d", i, current_vehicle);
                 }
@@ -229,30 +517,106 @@ void construct_initial_solution() {
             }
         }
     }
-    
-    // Add return to depot for all used vehicles
+}
+
+// Add return to depot for all used vehicles
+void close_routes() {
     for (int i = 0; i < n_vehicles; i++) {
         if (vehicles[i].route_size > 1) {
             if (vehicles[i].route_size < vehicles[i].route_capacity) {
-                vehicles[i].route[vehicles[i].route_size++] = 0;
+                int end_depot = vehicle_end_depot(&vehicles[i]);
+                vehicles[i].current_time += distances[vehicles[i].current_location][end_depot];
+                vehicles[i].current_location = end_depot;
+                vehicles[i].route[vehicles[i].route_size++] = end_depot;
                 DEBUG_PRINT("Added depot return for vehicle %d", i);
             }
         }
     }
 }
 
-// Solve VRPTW
-void solve_vrptw() {
-    printf("\nStarting VRPTW solution...\n");
+// Construct initial solution
+void construct_initial_solution() {
+    DEBUG_PRINT("Constructing initial solution");
     
-    initialize_distances();
-    construct_initial_solution();
+    init_vehicles();
+    assign_remaining_customers();
+    close_routes();
+}
+
+// Rebuild a solution from previous routes. Stops are replayed in order;
+// unknown, duplicate or now-infeasible stops are dropped and then
+// re-inserted greedily together with any customers the routes missed.
+void warm_start_solution(SavedRoute* routes, int n_routes) {
+    DEBUG_PRINT("Warm-starting from %d saved routes", n_routes);
     
-    printf("\nOptimizing routes...\n");
+    for (int i = n_depots; i < n_customers; i++) {
+        customers[i].is_served = false;
+    }
+    
+    init_vehicles();
+    
+    int repaired = 0;
+    for (int v = 0; v < n_routes; v++) {
+        for (int j = 0; j < routes[v].size; j++) {
+            int node = routes[v].nodes[j];
+            if (node < 0 || node >= n_customers || is_depot(node)) continue;
+            
+            if (v >= n_vehicles || customers[node].is_served ||
+                !append_customer(&vehicles[v], node)) {
+                DEBUG_PRINT("Repair: dropped stop %d from saved route %d", node, v);
+                repaired++;
+            }
+        }
+    }
+    
+    assign_remaining_customers();
+    close_routes();
+    
+    if (repaired > 0) {
+        printf("Warm start repaired %d stop(s)\n", repaired);
+    }
+}
+
+// Capture the current routes so they can be replayed by warm_start_solution
+int snapshot_routes(SavedRoute* routes) {
+    for (int i = 0; i < n_vehicles; i++) {
+        routes[i].type_id = vehicles[i].type_id;
+        routes[i].start_depot = vehicles[i].start_depot;
+        routes[i].end_depot = vehicles[i].end_depot;
+        routes[i].size = vehicles[i].route ? vehicles[i].route_size : 0;
+        if (routes[i].size > 0) {
+            memcpy(routes[i].nodes, vehicles[i].route, routes[i].size * sizeof(int));
+        }
+    }
+    return n_vehicles;
+}
+
+bool save_checkpoint(const char* filename);
+
+// Improve every route, checkpointing after each one when autosave is on
+void optimize_all_routes() {
     for (int i = 0; i < n_vehicles; i++) {
         optimize_route(&vehicles[i]);
+        if (checkpoint_path) {
+            save_checkpoint(checkpoint_path);
+        }
+    }
+}
+
+// Solve VRPTW, optionally warm-starting from previous routes
+void solve_vrptw(SavedRoute* start_routes, int n_start_routes) {
+    printf("\nStarting VRPTW solution...\n");
+    
+    initialize_distances();
+    if (start_routes) {
+        warm_start_solution(start_routes, n_start_routes);
+    } else {
+        construct_initial_solution();
     }
     
+    printf("\nOptimizing routes...\n");
+    optimize_all_routes();
+    
     printf("\nVRPTW Solution:\n");
     for (int i = 0; i < n_vehicles; i++) {
         printf("Vehicle %d route: ", i + 1);
@@ -266,12 +630,13 @@ void solve_vrptw() {
 // Print route details
 void print_route_details(Vehicle* vehicle, int vehicle_id) {
     printf("\n========= Vehicle %d Details =========\n", vehicle_id + 1);
+    printf("Type: %s\n", vehicle_types[vehicle->type_id].name);
     printf("Capacity: %d/%d\n", vehicle->current_load, vehicle->capacity);
     printf("Total Time: %d minutes\n", vehicle->current_time);
-    printf("Route: Depot");
+    printf("Route: Depot %d", vehicle->route[0]);
     
     int total_distance = 0;
-    int current_time = 0;
+    int current_time = vehicle_shift_start(vehicle);
     
     for (int i = 1; i < vehicle->route_size; i++) {
         int prev = vehicle->route[i-1];
@@ -279,7 +644,7 @@ void print_route_details(Vehicle* vehicle, int vehicle_id) {
         total_distance += distances[prev][curr];
         
         current_time += distances[prev][curr];
-        if (curr != 0) {  // Don't print details for depot
+        if (!is_depot(curr)) {  // Don't print details for depot
             printf("\n→ Customer %d:", curr);
             printf("\n  Location: (%d, %d)", customers[curr].x, customers[curr].y);
             printf("\n  Arrival Time: %d", current_time);
@@ -289,13 +654,14 @@ void print_route_details(Vehicle* vehicle, int vehicle_id) {
             printf("\n  Service Time: %d", customers[curr].time_window.service_time);
             printf("\n  Demand: %d", customers[curr].demand);
             
-            current_time += customers[curr].time_window.service_time;
+            current_time = departure_time(curr, current_time);
         } else {
-            printf("\n→ Return to Depot");
+            printf("\n→ Return to Depot %d", curr);
         }
     }
     
     printf("\nTotal Distance: %d units\n", total_distance);
+    printf("Total Cost: %d\n", route_cost(vehicle, total_distance));
     printf("=====================================\n");
 }
 
@@ -354,10 +720,12 @@ void visualize_routes(int cust, int veh) {
     int offset_x = (GRID_SIZE - (int)((max_x - min_x) * scale)) / 2;
     int offset_y = (GRID_SIZE - (int)((max_y - min_y) * scale)) / 2;
 
-    // Mark depot
-    int depot_x, depot_y;
-    convert_coord(customers[0].x, customers[0].y, min_x, min_y, scale, offset_x, offset_y, &depot_x, &depot_y);
-    grid[depot_y][depot_x] = 'D';
+    // Mark depots
+    for (int d = 0; d < n_depots; d++) {
+        int depot_x, depot_y;
+        convert_coord(customers[d].x, customers[d].y, min_x, min_y, scale, offset_x, offset_y, &depot_x, &depot_y);
+        grid[depot_y][depot_x] = 'D';
+    }
 
     // Draw routes for each vehicle
     for (int v = 0; v < n_vehicles; v++) {
@@ -374,10 +742,10 @@ void visualize_routes(int cust, int veh) {
             convert_coord(customers[next_customer].x, customers[next_customer].y, min_x, min_y, scale, offset_x, offset_y, &x2, &y2);
 
             // Mark customer locations (except depot)
-            if (curr_customer != 0) {
+            if (!is_depot(curr_customer)) {
                 grid[y1][x1] = 'C';
             }
-            if (next_customer != 0) {
+            if (!is_depot(next_customer)) {
                 grid[y2][x2] = 'C';
             }
 
@@ -414,24 +782,25 @@ void visualize_routes(int cust, int veh) {
     printf("\n====== Route Visualization ======\n");
     printf("D: Depot, C: Customer, .: Path\n\n");
 
-    // Print top border
-    printf("+");
-    for (int i = 0; i < GRID_SIZE; i++) printf("-");
-    printf("+\n");
+    // Build each line once and write it in a single call
+    char line[GRID_SIZE + 4];
+    line[0] = '+';
+    memset(line + 1, '-', GRID_SIZE);
+    line[GRID_SIZE + 1] = '+';
+    line[GRID_SIZE + 2] = '\n';
+    line[GRID_SIZE + 3] = '\0';
+    char border[GRID_SIZE + 4];
+    memcpy(border, line, sizeof(line));
 
-    // Print grid with side borders
+    // Print grid with borders
+    fputs(border, stdout);
+    line[0] = '|';
+    line[GRID_SIZE + 1] = '|';
     for (int i = 0; i < GRID_SIZE; i++) {
-        printf("|");
-        for (int j = 0; j < GRID_SIZE; j++) {
-            printf("%c", grid[i][j]);
-        }
-        printf("|\n");
+        memcpy(line + 1, grid[i], GRID_SIZE);
+        fputs(line, stdout);
     }
-
-    // Print bottom border
-    printf("+");
-    for (int i = 0; i < GRID_SIZE; i++) printf("-");
-    printf("+\n");
+    fputs(border, stdout);
 
     printf("==============================\n");
 }
@@ -443,37 +812,564 @@ void print_statistics() {
     
     int total_distance = 0;
     int total_load = 0;
+    int total_cost = 0;
     int max_time = 0;
     
     for (int i = 0; i < n_vehicles; i++) {
         Vehicle* vehicle = &vehicles[i];
-        int vehicle_distance = 0;
-        
-        for (int j = 1; j < vehicle->route_size; j++) {
-            int prev = vehicle->route[j-1];
-            int curr = vehicle->route[j];
-            vehicle_distance += distances[prev][curr];
-        }
+        RouteEval eval;
+        evaluate_route_cached(vehicle, &eval);
+        int cost = route_cost(vehicle, eval.distance);
         
-        total_distance += vehicle_distance;
-        total_load += vehicle->current_load;
-        max_time = MAX(max_time, vehicle->current_time);
+        total_distance += eval.distance;
+        total_load += eval.load;
+        total_cost += cost;
+        max_time = MAX(max_time, eval.duration);
         
-        printf("Vehicle %d:\n", i + 1);
-        printf("  Distance: %d units\n", vehicle_distance);
-        printf("  Load: %d/%d\n", vehicle->current_load, vehicle->capacity);
-        printf("  Time: %d minutes\n", vehicle->current_time);
+        printf("Vehicle %d (%s, depot %d -> %d):\n", i + 1,
+               vehicle_types[vehicle->type_id].name,
+               vehicle_start_depot(vehicle), vehicle_end_depot(vehicle));
+        printf("  Distance: %d units\n", eval.distance);
+        printf("  Load: %d/%d\n", eval.load, vehicle->capacity);
+        printf("  Time: %d minutes\n", eval.duration);
+        printf("  Cost: %d\n", cost);
     }
     
     printf("\nOverall Statistics:\n");
     printf("Total Distance: %d units\n", total_distance);
     printf("Total Load: %d units\n", total_load);
+    printf("Total Cost: %d\n", total_cost);
     printf("Maximum Route Time: %d minutes\n", max_time);
+    
+    uint64_t hits = atomic_load(&route_cache_hits);
+    uint64_t misses = atomic_load(&route_cache_misses);
+    uint64_t evictions = atomic_load(&route_cache_evictions);
+    printf("\nRoute Cache:\n");
+    printf("Hits: %" PRIu64 ", Misses: %" PRIu64 ", Evictions: %" PRIu64 "\n",
+           hits, misses, evictions);
+    printf("Hit Rate: %.1f%%\n", hits + misses ? 100.0 * hits / (hits + misses) : 0.0);
     printf("==============================\n");
 }
 
+// Buffered output stream: formatted text is collected in memory and
+// handed to the FILE in one fwrite per OUT_BUFFER_SIZE bytes
+typedef struct {
+    FILE* file;
+    char data[OUT_BUFFER_SIZE];
+    size_t length;
+} OutBuffer;
+
+void out_flush(OutBuffer* out) {
+    if (out->length > 0) {
+        fwrite(out->data, 1, out->length, out->file);
+        out->length = 0;
+    }
+}
+
+void out_printf(OutBuffer* out, const char* fmt, ...) {
+    va_list args;
+    size_t space = OUT_BUFFER_SIZE - out->length;
+    
+    va_start(args, fmt);
+    int written = vsnprintf(out->data + out->length, space, fmt, args);
+    va_end(args);
+    
+    if (written < 0) return;
+    
+    if ((size_t)written >= space) {
+        // Did not fit: flush and format again into the empty buffer
+        out_flush(out);
+        va_start(args, fmt);
+        written = vsnprintf(out->data, OUT_BUFFER_SIZE, fmt, args);
+        va_end(args);
+        if (written < 0) return;
+        if ((size_t)written >= OUT_BUFFER_SIZE) {
+            // Longer than a whole buffer; write it straight through
+            va_start(args, fmt);
+            vfprintf(out->file, fmt, args);
+            va_end(args);
+            return;
+        }
+    }
+    out->length += written;
+}
+
+OutBuffer* out_open(const char* filename) {
+    OutBuffer* out = (OutBuffer*)malloc(sizeof(OutBuffer));
+    if (!out) {
+        fprintf(stderr, "Memory allocation failed for output buffer\n");
+        return NULL;
+    }
+    out->file = fopen(filename, "w");
+    if (!out->file) {
+        fprintf(stderr, "Could not open %s for writing\n", filename);
+        free(out);
+        return NULL;
+    }
+    out->length = 0;
+    return out;
+}
+
+bool out_close(OutBuffer* out) {
+    out_flush(out);
+    bool ok = !ferror(out->file);
+    ok = (fclose(out->file) == 0) && ok;
+    free(out);
+    return ok;
+}
+
+// Write text as a quoted JSON string
+void out_json_string(OutBuffer* out, const char* text) {
+    out_printf(out, "\"");
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out_printf(out, "\\%c", *c);
+        } else if (*c < 0x20) {
+            out_printf(out, "\\u%04x", *c);
+        } else {
+            out_printf(out, "%c", *c);
+        }
+    }
+    out_printf(out, "\"");
+}
+
+// Write text as a CSV field, quoting it if it contains separators or quotes
+void out_csv_field(OutBuffer* out, const char* text) {
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        out_printf(out, "%s", text);
+        return;
+    }
+    out_printf(out, "\"");
+    for (const char* c = text; *c; c++) {
+        out_printf(out, *c == '"' ? "\"\"" : "%c", *c);
+    }
+    out_printf(out, "\"");
+}
+
+// Export routes as JSON for downstream dispatch tools
+bool export_json(const char* filename) {
+    OutBuffer* out = out_open(filename);
+    if (!out) return false;
+    
+    int total_distance = 0;
+    int total_cost = 0;
+    
+    out_printf(out, "{\n  \"depots\": [");
+    for (int d = 0; d < n_depots; d++) {
+        out_printf(out, "%s{\"id\": %d, \"x\": %d, \"y\": %d}",
+                   d ? ", " : "", d, customers[d].x, customers[d].y);
+    }
+    out_printf(out, "],\n  \"vehicles\": [");
+    
+    for (int i = 0; i < n_vehicles; i++) {
+        Vehicle* vehicle = &vehicles[i];
+        RouteEval eval;
+        evaluate_route_cached(vehicle, &eval);
+        int cost = route_cost(vehicle, eval.distance);
+        total_distance += eval.distance;
+        total_cost += cost;
+        
+        out_printf(out, "%s\n    {\"id\": %d, \"type\": ", i ? "," : "", i + 1);
+        out_json_string(out, vehicle_types[vehicle->type_id].name);
+        out_printf(out, ", \"start_depot\": %d, \"end_depot\": %d, "
+                   "\"capacity\": %d, \"load\": %d, \"duration\": %d, \"distance\": %d, \"cost\": %d, "
+                   "\"route\": [",
+                   vehicle_start_depot(vehicle), vehicle_end_depot(vehicle),
+                   vehicle->capacity, eval.load, eval.duration,
+                   eval.distance, cost);
+        for (int j = 0; j < vehicle->route_size; j++) {
+            out_printf(out, "%s%d", j ? ", " : "", vehicle->route[j]);
+        }
+        out_printf(out, "]}");
+    }
+    
+    out_printf(out, "\n  ],\n  \"total_distance\": %d,\n  \"total_cost\": %d\n}\n",
+               total_distance, total_cost);
+    return out_close(out);
+}
+
+// Export one row per stop as CSV, with simulated arrival/departure times
+bool export_csv(const char* filename) {
+    OutBuffer* out = out_open(filename);
+    if (!out) return false;
+    
+    out_printf(out, "vehicle,type,sequence,node,x,y,arrival,departure,load\n");
+    
+    for (int i = 0; i < n_vehicles; i++) {
+        Vehicle* vehicle = &vehicles[i];
+        if (vehicle->route_size <= 1) continue;
+        
+        const char* type_name = vehicle_types[vehicle->type_id].name;
+        int current_time = vehicle_shift_start(vehicle);
+        int load = 0;
+        
+        for (int j = 0; j < vehicle->route_size; j++) {
+            int node = vehicle->route[j];
+            int arrival = current_time;
+            if (j > 0) {
+                arrival += distances[vehicle->route[j-1]][node];
+            }
+            current_time = is_depot(node) ? arrival : departure_time(node, arrival);
+            load += customers[node].demand;
+            
+            out_printf(out, "%d,", i + 1);
+            out_csv_field(out, type_name);
+            out_printf(out, ",%d,%d,%d,%d,%d,%d,%d\n",
+                       j, node, customers[node].x, customers[node].y,
+                       arrival, current_time, load);
+        }
+    }
+    
+    return out_close(out);
+}
+
+// Export in the standard .sol format (one "Route #k:" line per used vehicle).
+// Customers are renumbered from 1 and Cost is the total distance, as the
+// format expects; fleet costs are in the JSON export.
+bool export_sol(const char* filename) {
+    OutBuffer* out = out_open(filename);
+    if (!out) return false;
+    
+    int route_number = 0;
+    int total_distance = 0;
+    
+    for (int i = 0; i < n_vehicles; i++) {
+        Vehicle* vehicle = &vehicles[i];
+        if (vehicle->route_size <= 2) continue;
+        
+        out_printf(out, "Route #%d:", ++route_number);
+        for (int j = 0; j < vehicle->route_size; j++) {
+            if (!is_depot(vehicle->route[j])) {
+                out_printf(out, " %d", vehicle->route[j] - n_depots + 1);
+            }
+        }
+        out_printf(out, "\n");
+        total_distance += route_distance(vehicle);
+    }
+    
+    out_printf(out, "Cost %d\n", total_distance);
+    return out_close(out);
+}
+
+// Render routes as a vector SVG; scales with the data instead of a fixed grid
+bool export_svg(const char* filename) {
+    static const char* palette[] = {
+        "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd",
+        "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22", "#17becf"
+    };
+    const int n_colors = sizeof(palette) / sizeof(palette[0]);
+    
+    OutBuffer* out = out_open(filename);
+    if (!out) return false;
+    
+    int min_x = customers[0].x, max_x = customers[0].x;
+    int min_y = customers[0].y, max_y = customers[0].y;
+    for (int i = 1; i < n_customers; i++) {
+        min_x = MIN(min_x, customers[i].x);
+        max_x = MAX(max_x, customers[i].x);
+        min_y = MIN(min_y, customers[i].y);
+        max_y = MAX(max_y, customers[i].y);
+    }
+    
+    // Marker sizes are relative to the plotted extent
+    double extent = MAX(MAX(max_x - min_x, max_y - min_y), 1);
+    double pad = extent * 0.05;
+    double radius = extent * 0.006;
+    double stroke = extent * 0.002;
+    
+    // SVG y grows downwards, so flip y to keep north up
+    out_printf(out, "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"%g %g %g %g\" "
+               "width=\"1000\" height=\"1000\" preserveAspectRatio=\"xMidYMid meet\">\n",
+               min_x - pad, -max_y - pad, (max_x - min_x) + 2 * pad, (max_y - min_y) + 2 * pad);
+    out_printf(out, "<rect x=\"%g\" y=\"%g\" width=\"%g\" height=\"%g\" fill=\"white\"/>\n",
+               min_x - pad, -max_y - pad, (max_x - min_x) + 2 * pad, (max_y - min_y) + 2 * pad);
+    
+    for (int i = 0; i < n_vehicles; i++) {
+        Vehicle* vehicle = &vehicles[i];
+        if (vehicle->route_size <= 1) continue;
+        
+        const char* color = palette[i % n_colors];
+        out_printf(out, "<g id=\"vehicle-%d\" stroke=\"%s\" fill=\"%s\">\n", i + 1, color, color);
+        out_printf(out, "<polyline fill=\"none\" stroke-width=\"%g\" points=\"", stroke);
+        for (int j = 0; j < vehicle->route_size; j++) {
+            int node = vehicle->route[j];
+            out_printf(out, "%s%d,%d", j ? " " : "", customers[node].x, -customers[node].y);
+        }
+        out_printf(out, "\"/>\n");
+        for (int j = 0; j < vehicle->route_size; j++) {
+            int node = vehicle->route[j];
+            if (is_depot(node)) continue;
+            out_printf(out, "<circle cx=\"%d\" cy=\"%d\" r=\"%g\" stroke=\"none\"/>\n",
+                       customers[node].x, -customers[node].y, radius);
+        }
+        out_printf(out, "</g>\n");
+    }
+    
+    // Unserved customers in grey, depots on top as black squares
+    for (int i = n_depots; i < n_customers; i++) {
+        if (!customers[i].is_served) {
+            out_printf(out, "<circle cx=\"%d\" cy=\"%d\" r=\"%g\" fill=\"#bbbbbb\"/>\n",
+                       customers[i].x, -customers[i].y, radius);
+        }
+    }
+    for (int d = 0; d < n_depots; d++) {
+        out_printf(out, "<rect x=\"%g\" y=\"%g\" width=\"%g\" height=\"%g\" fill=\"black\"/>\n",
+                   customers[d].x - 2 * radius, -customers[d].y - 2 * radius, 4 * radius, 4 * radius);
+    }
+    
+    out_printf(out, "</svg>\n");
+    return out_close(out);
+}
+
+// Export the current solution in every supported format
+void export_solution(const char* basename) {
+    static const char* extensions[] = {"json", "csv", "sol", "svg"};
+    bool (*exporters[])(const char*) = {export_json, export_csv, export_sol, export_svg};
+    char filename[512];
+    
+    for (int i = 0; i < 4; i++) {
+        snprintf(filename, sizeof(filename), "%s.%s", basename, extensions[i]);
+        if (exporters[i](filename)) {
+            printf("Wrote %s\n", filename);
+        } else {
+            fprintf(stderr, "Failed to write %s\n", filename);
+        }
+    }
+}
+
+// Atomically replace dst with src. rename() on Windows runtimes fails if
+// dst already exists, so use MoveFileEx there.
+bool replace_file(const char* src, const char* dst) {
+#ifdef _WIN32
+    return MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(src, dst) == 0;
+#endif
+}
+
+// Save the full solver state: RNG, constraint set, instance and routes.
+// Written to a temporary file and renamed so a crash never leaves a
+// truncated checkpoint behind.
+bool save_checkpoint(const char* filename) {
+    char tmp_name[512];
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", filename);
+    
+    OutBuffer* out = out_open(tmp_name);
+    if (!out) return false;
+    
+    out_printf(out, "VRPTW-CHECKPOINT %d\n", CHECKPOINT_VERSION);
+    out_printf(out, "seed %" PRIu64 "\n", rng_seed_value);
+    out_printf(out, "rng %" PRIu64 "\n", rng_state);
+    out_printf(out, "constraints %d\n", VRP_CONSTRAINTS);
+    
+    out_printf(out, "nodes %d %d\n", n_customers, n_depots);
+    for (int i = 0; i < n_customers; i++) {
+        out_printf(out, "%d %d %d %d %d %d\n", customers[i].x, customers[i].y,
+                   customers[i].time_window.earliest, customers[i].time_window.latest,
+                   customers[i].time_window.service_time, customers[i].demand);
+    }
+    
+    out_printf(out, "types %d\n", n_vehicle_types);
+    for (int t = 0; t < n_vehicle_types; t++) {
+        VehicleType* type = &vehicle_types[t];
+        out_printf(out, "%s %d %d %d %d %d\n", type->name, type->capacity,
+                   type->fixed_cost, type->variable_cost, type->shift_start, type->shift_end);
+    }
+    
+    out_printf(out, "vehicles %d\n", n_vehicles);
+    for (int i = 0; i < n_vehicles; i++) {
+        Vehicle* vehicle = &vehicles[i];
+        int size = vehicle->route ? vehicle->route_size : 0;
+        out_printf(out, "%d %d %d %d", vehicle->type_id, vehicle->start_depot,
+                   vehicle->end_depot, size);
+        for (int j = 0; j < size; j++) {
+            out_printf(out, " %d", vehicle->route[j]);
+        }
+        out_printf(out, "\n");
+    }
+    out_printf(out, "end\n");
+    
+    if (!out_close(out)) {
+        remove(tmp_name);
+        return false;
+    }
+    if (!replace_file(tmp_name, filename)) {
+        fprintf(stderr, "Could not replace %s\n", filename);
+        remove(tmp_name);
+        return false;
+    }
+    return true;
+}
+
+// Parsed contents of a checkpoint file
+typedef struct {
+    uint64_t seed, rng_state;
+    int constraints;
+    int n_nodes, n_depots, n_types, n_routes;
+    Customer nodes[MAX_NODES];
+    VehicleType types[MAX_VEHICLE_TYPES];
+    SavedRoute routes[MAX_VEHICLES];
+} Checkpoint;
+
+bool read_checkpoint(const char* filename, Checkpoint* ckpt) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Could not open checkpoint %s\n", filename);
+        return false;
+    }
+    
+    bool ok = false;
+    int version;
+    uint64_t seed, state;
+    
+    if (fscanf(file, "VRPTW-CHECKPOINT %d", &version) != 1 || version != CHECKPOINT_VERSION) goto done;
+    if (fscanf(file, " seed %" SCNu64 " rng %" SCNu64, &seed, &state) != 2) goto done;
+    if (fscanf(file, " constraints %d", &ckpt->constraints) != 1) goto done;
+    ckpt->seed = seed;
+    ckpt->rng_state = state;
+    
+    if (fscanf(file, " nodes %d %d", &ckpt->n_nodes, &ckpt->n_depots) != 2 ||
+        ckpt->n_nodes < 1 || ckpt->n_nodes > MAX_NODES ||
+        ckpt->n_depots < 1 || ckpt->n_depots > ckpt->n_nodes) goto done;
+    for (int i = 0; i < ckpt->n_nodes; i++) {
+        Customer* c = &ckpt->nodes[i];
+        if (fscanf(file, "%d %d %d %d %d %d", &c->x, &c->y,
+                   &c->time_window.earliest, &c->time_window.latest,
+                   &c->time_window.service_time, &c->demand) != 6) goto done;
+        c->is_served = i < ckpt->n_depots;
+    }
+    
+    if (fscanf(file, " types %d", &ckpt->n_types) != 1 ||
+        ckpt->n_types < 1 || ckpt->n_types > MAX_VEHICLE_TYPES) goto done;
+    for (int t = 0; t < ckpt->n_types; t++) {
+        VehicleType* type = &ckpt->types[t];
+        if (fscanf(file, "%15s %d %d %d %d %d", type->name, &type->capacity,
+                   &type->fixed_cost, &type->variable_cost,
+                   &type->shift_start, &type->shift_end) != 6) goto done;
+    }
+    
+    if (fscanf(file, " vehicles %d", &ckpt->n_routes) != 1 ||
+        ckpt->n_routes < 1 || ckpt->n_routes > MAX_VEHICLES) goto done;
+    for (int v = 0; v < ckpt->n_routes; v++) {
+        SavedRoute* route = &ckpt->routes[v];
+        if (fscanf(file, "%d %d %d %d", &route->type_id, &route->start_depot,
+                   &route->end_depot, &route->size) != 4 ||
+            route->type_id < 0 || route->type_id >= ckpt->n_types ||
+            route->start_depot < 0 || route->start_depot >= ckpt->n_depots ||
+            route->end_depot < 0 || route->end_depot >= ckpt->n_depots ||
+            route->size < 0 || route->size > MAX_NODES) goto done;
+        for (int j = 0; j < route->size; j++) {
+            if (fscanf(file, "%d", &route->nodes[j]) != 1) goto done;
+        }
+    }
+    
+    char trailer[8];
+    ok = fscanf(file, "%7s", trailer) == 1 && strcmp(trailer, "end") == 0;
+    
+done:
+    if (!ok) {
+        fprintf(stderr, "Malformed checkpoint %s\n", filename);
+    }
+    fclose(file);
+    return ok;
+}
+
+// Load a checkpoint into routes. With restore_instance the saved instance,
+// fleet and RNG state replace the current ones (resume). Otherwise the
+// current instance is kept and saved stops are remapped onto it by
+// location, falling back to the saved ID for customers that moved, so a
+// plan for a slightly changed instance can seed the search.
+bool load_checkpoint(const char* filename, bool restore_instance,
+                     SavedRoute* routes, int* n_routes) {
+    static Checkpoint ckpt;
+    
+    if (!read_checkpoint(filename, &ckpt)) return false;
+    
+    if (ckpt.constraints != VRP_CONSTRAINTS) {
+        printf("Note: checkpoint was written with constraint set %d, running with %d\n",
+               ckpt.constraints, VRP_CONSTRAINTS);
+    }
+    
+    if (restore_instance) {
+        n_customers = ckpt.n_nodes;
+        n_depots = ckpt.n_depots;
+        memcpy(customers, ckpt.nodes, ckpt.n_nodes * sizeof(Customer));
+        n_vehicle_types = ckpt.n_types;
+        memcpy(vehicle_types, ckpt.types, ckpt.n_types * sizeof(VehicleType));
+        
+        for (int i = 0; i < n_vehicles; i++) {
+            free(vehicles[i].route);
+            vehicles[i].route = NULL;
+        }
+        n_vehicles = ckpt.n_routes;
+        for (int i = 0; i < n_vehicles; i++) {
+            vehicles[i].type_id = ckpt.routes[i].type_id;
+            vehicles[i].start_depot = ckpt.routes[i].start_depot;
+            vehicles[i].end_depot = ckpt.routes[i].end_depot;
+        }
+        
+        rng_seed_value = ckpt.seed;
+        rng_state = ckpt.rng_state;
+        initialize_distances();
+        
+        memcpy(routes, ckpt.routes, ckpt.n_routes * sizeof(SavedRoute));
+        *n_routes = ckpt.n_routes;
+        return true;
+    }
+    
+    // Map each saved node to the first unused current customer at the same location
+    int remap[MAX_NODES];
+    bool taken[MAX_NODES] = {false};
+    int unmatched = 0;
+    
+    for (int i = 0; i < ckpt.n_nodes; i++) {
+        remap[i] = -1;
+        if (i < ckpt.n_depots) continue;
+        for (int j = n_depots; j < n_customers; j++) {
+            if (!taken[j] && customers[j].x == ckpt.nodes[i].x && customers[j].y == ckpt.nodes[i].y) {
+                remap[i] = j;
+                taken[j] = true;
+                break;
+            }
+        }
+    }
+    
+    // Customers that moved keep their saved ID if it is still free
+    int matched_by_id = 0;
+    for (int i = ckpt.n_depots; i < ckpt.n_nodes; i++) {
+        if (remap[i] >= 0) continue;
+        if (i >= n_depots && i < n_customers && !taken[i]) {
+            remap[i] = i;
+            taken[i] = true;
+            matched_by_id++;
+        } else {
+            unmatched++;
+        }
+    }
+    
+    for (int v = 0; v < ckpt.n_routes; v++) {
+        routes[v] = ckpt.routes[v];
+        routes[v].size = 0;
+        for (int j = 0; j < ckpt.routes[v].size; j++) {
+            int node = ckpt.routes[v].nodes[j];
+            if (node < 0 || node >= ckpt.n_nodes || remap[node] < 0) continue;
+            routes[v].nodes[routes[v].size++] = remap[node];
+        }
+    }
+    *n_routes = ckpt.n_routes;
+    
+    if (matched_by_id > 0) {
+        printf("Warm start: %d saved customer(s) matched by ID instead of location\n", matched_by_id);
+    }
+    if (unmatched > 0) {
+        printf("Warm start: %d saved customer(s) could not be matched by location or ID\n", unmatched);
+    }
+    return true;
+}
+
 // Interactive menu
 void interactive_menu() {
+    static SavedRoute saved_routes[MAX_VEHICLES];
     char buffer[256];
     
     while (1) {
@@ -483,7 +1379,10 @@ void interactive_menu() {
         printf("3. Show Solution Statistics\n");
         printf("4. Modify Customer Data\n");
 printf("5. Re-optimize Routes\n");
-printf("6. Exit\n");
+printf("6. Export Solution (JSON/CSV/SOL/SVG)\n");
+printf("7. Save Checkpoint\n");
+printf("8. Warm-start from Checkpoint\n");
+printf("9. Exit\n");
 printf("\nEnter your choice: ");
 
 if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
@@ -510,14 +1409,14 @@ switch (choice) {
         break;
         
     case 4: {
-        printf("\nEnter customer ID to modify (1-%d): ", n_customers - 1);
+        printf("\nEnter customer ID to modify (%d-%d): ", n_depots, n_customers - 1);
         if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
             printf("Error reading input\n");
             break;
         }
         int customer_id = atoi(buffer);
         
-        if (customer_id <= 0 || customer_id >= n_customers) {
+        if (customer_id < n_depots || customer_id >= n_customers) {
             printf("Invalid customer ID\n");
             break;
         }
@@ -560,26 +1459,61 @@ switch (choice) {
         break;
     }
         
-    case 5:
-        // Reset all customer served flags
-        for (int i = 1; i < n_customers; i++) {
-            customers[i].is_served = false;
+    case 5: {
+        // Warm-start from the current routes, repairing stops that the
+        // customer changes made infeasible
+        int n_routes = snapshot_routes(saved_routes);
+        warm_start_solution(saved_routes, n_routes);
+        optimize_all_routes();
+        printf("Routes have been re-optimized\n");
+        break;
+    }
+        
+    case 6: {
+        printf("\nEnter output file name without extension: ");
+        if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
+            printf("Error reading input\n");
+            break;
+        }
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+        if (buffer[0] == '\0') {
+            printf("Invalid file name\n");
+            break;
         }
+        export_solution(buffer);
+        break;
+    }
         
-        // Free existing routes
-        for (int i = 0; i < n_vehicles; i++) {
-            free(vehicles[i].route);
+    case 7:
+        printf("\nEnter checkpoint file name: ");
+        if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
+            printf("Error reading input\n");
+            break;
+        }
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+        if (save_checkpoint(buffer)) {
+            printf("Checkpoint saved to %s\n", buffer);
+        } else {
+            fprintf(stderr, "Failed to save checkpoint\n");
         }
+        break;
         
-        // Reconstruct and optimize solution
-        construct_initial_solution();
-        for (int i = 0; i < n_vehicles; i++) {
-            optimize_route(&vehicles[i]);
+    case 8: {
+        printf("\nEnter checkpoint file name: ");
+        if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
+            printf("Error reading input\n");
+            break;
         }
-        printf("Routes have been re-optimized\n");
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+        int n_routes;
+        if (!load_checkpoint(buffer, false, saved_routes, &n_routes)) break;
+        warm_start_solution(saved_routes, n_routes);
+        optimize_all_routes();
+        printf("Routes warm-started from %s\n", buffer);
         break;
+    }
         
-    case 6:
+    case 9:
         printf("Exiting program...\n");
         // Free allocated memory
         for (int i = 0; i < n_vehicles; i++) {
@@ -595,39 +1529,93 @@ switch (choice) {
 }
 
 // Main function with example problem instance
-int main() {
-    srand(time(NULL));  // Initialize random seed
+//   --seed N          seed the instance generator
+//   --resume FILE     restore instance, fleet, RNG and routes from a checkpoint
+//   --warm-start FILE seed construction with routes from a checkpoint
+//   --checkpoint FILE autosave solver state while optimizing
+int main(int argc, char* argv[]) {
+    uint64_t seed = (uint64_t)time(NULL);
+    const char* resume_path = NULL;
+    const char* warm_start_path = NULL;
+    
+    bool usage_error = false;
+    
+    for (int i = 1; i < argc && !usage_error; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--seed") == 0) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--resume") == 0) {
+            resume_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--warm-start") == 0) {
+            warm_start_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--checkpoint") == 0) {
+            checkpoint_path = argv[++i];
+        } else {
+            usage_error = true;
+        }
+    }
+    
+    // --resume and --warm-start are alternative ways to seed the solver
+    if (usage_error || (resume_path && warm_start_path)) {
+        fprintf(stderr, "Usage: %s [--seed N] [--resume FILE | --warm-start FILE] [--checkpoint FILE]\n", argv[0]);
+        return 1;
+    }
+    
+    rng_seed(seed);  // Initialize random seed
     
     // Set up example problem
-    n_customers = 10;  // Including depot
-    n_vehicles = 3;
-    
-    // Initialize depot (customer 0)
-    customers[0].x = 0;
-    customers[0].y = 0;
-    customers[0].time_window.earliest = 0;
-    customers[0].time_window.latest = INF;
-    customers[0].time_window.service_time = 0;
-    customers[0].demand = 0;
-    customers[0].is_served = true;
+    n_customers = 12;  // Including depots
+    n_depots = VRP_HAS(VRP_C_MULTI_DEPOT) ? 2 : 1;
+    n_vehicles = 4;
+    
+    // Vehicle types: name, capacity, fixed cost, variable cost, shift window
+    n_vehicle_types = 2;
+    vehicle_types[0] = (VehicleType){"Van", 60, 50, 1, 0, 300};
+    vehicle_types[1] = (VehicleType){"Truck", 150, 120, 2, 0, 480};
+    
+    // Alternate vans and trucks across the depots
+    for (int i = 0; i < n_vehicles; i++) {
+        vehicles[i].type_id = i % n_vehicle_types;
+        vehicles[i].start_depot = i % n_depots;
+        vehicles[i].end_depot = i % n_depots;
+    }
+    
+    // Initialize depots (customers 0..n_depots-1)
+    for (int d = 0; d < n_depots; d++) {
+        customers[d].x = d == 0 ? 0 : rng_int(20) - 10;
+        customers[d].y = d == 0 ? 0 : rng_int(20) - 10;
+        customers[d].time_window.earliest = 0;
+        customers[d].time_window.latest = INF;
+        customers[d].time_window.service_time = 0;
+        customers[d].demand = 0;
+        customers[d].is_served = true;
+    }
     
     // Generate random customers
-    for (int i = 1; i < n_customers; i++) {
-        customers[i].x = rand() % 20 - 10;  // Random coordinates between -10 and 10
-        customers[i].y = rand() % 20 - 10;
-        customers[i].time_window.earliest = rand() % 100;  // Random time windows
-        customers[i].time_window.latest = customers[i].time_window.earliest + 50 + rand() % 100;
-        customers[i].time_window.service_time = 10 + rand() % 20;  // Service time between 10-30
-        customers[i].demand = 5 + rand() % 20;  // Demand between 5-25
+    for (int i = n_depots; i < n_customers; i++) {
+        customers[i].x = rng_int(20) - 10;  // Random coordinates between -10 and 10
+        customers[i].y = rng_int(20) - 10;
+        customers[i].time_window.earliest = rng_int(100);  // Random time windows
+        customers[i].time_window.latest = customers[i].time_window.earliest + 50 + rng_int(100);
+        customers[i].time_window.service_time = 10 + rng_int(20);  // Service time between 10-30
+        customers[i].demand = 5 + rng_int(20);  // Demand between 5-25
         customers[i].is_served = false;
     }
     
+    static SavedRoute start_routes[MAX_VEHICLES];
+    int n_start_routes = 0;
+    const char* start_path = resume_path ? resume_path : warm_start_path;
+    
+    if (start_path && !load_checkpoint(start_path, resume_path != NULL, start_routes, &n_start_routes)) {
+        return 1;
+    }
+    
     printf("VRPTW Solver\n");
-    printf("Customers: %d\n", n_customers - 1);
+    printf("Customers: %d\n", n_customers - n_depots);
+    printf("Depots: %d\n", n_depots);
     printf("Vehicles: %d\n", n_vehicles);
     
     // Solve the problem
-    solve_vrptw();
+    solve_vrptw(start_path ? start_routes : NULL, n_start_routes);
     
     // Enter interactive menu
     interactive_menu();